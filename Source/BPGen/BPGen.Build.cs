@@ -45,6 +45,7 @@ public class BPGen : ModuleRules
 				"SlateCore",
 				"BlueprintGraph",
 				"EditorScriptingUtilities",
+				"ContentBrowser",
 				"Json"
 				// ... add private dependencies that you statically link with here ...	
 			}
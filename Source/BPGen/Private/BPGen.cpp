@@ -9,8 +9,25 @@
 #include "GenericPlatform/GenericPlatformMisc.h"
 #include "K2Node_CallFunction.h"
 #include "K2Node_IfThenElse.h"
+#include "K2Node_MacroInstance.h"
+#include "K2Node_DynamicCast.h"
+#include "K2Node_BaseAsyncTask.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/StreamableManager.h"
+#include "ContentBrowserModule.h"
+#include "IContentBrowserSingleton.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Kismet2/CompilerResultsLog.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "K2Node_CustomEvent.h"
+#include "K2Node_VariableGet.h"
+#include "K2Node_VariableSet.h"
+#include "Misc/ScopedSlowTask.h"
+#include "GameFramework/Actor.h"
 #include "LevelEditor.h"
 #include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 #include "Templates/SharedPointer.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "Widgets/Layout/SBox.h"
@@ -29,7 +46,9 @@
 //#include "JsonObjectConverter.h"
 #include "Serialization/JsonSerializer.h"
 #include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
 #include "Internationalization/Regex.h"
+#include "UObject/EnumProperty.h"
 
 
 
@@ -158,6 +177,34 @@ static UK2Node_IfThenElse* CreateBranchNode(UEdGraph* EventGraph) {
 	return GetOwnerNode;
 }
 
+static UK2Node_CustomEvent* CreateCustomEventNode(UEdGraph* EventGraph, FName EventName) {
+	UK2Node_CustomEvent* GetOwnerNode = NewObject<UK2Node_CustomEvent>(EventGraph);
+	GetOwnerNode->CustomFunctionName = EventName;
+	GetOwnerNode->CreateNewGuid();
+	GetOwnerNode->PostPlacedNewNode();
+	GetOwnerNode->SetFlags(RF_Transactional);
+	GetOwnerNode->AllocateDefaultPins();
+	UEdGraphSchema_K2::SetNodeMetaData(GetOwnerNode, FNodeMetadata::DefaultGraphNode);
+	GetOwnerNode->SetEnabledState(ENodeEnabledState::Enabled);
+	EventGraph->AddNode(GetOwnerNode);
+	return GetOwnerNode;
+}
+
+// T is UK2Node_VariableGet or UK2Node_VariableSet; the variable must already exist on the skeleton class
+template <typename T>
+static T* CreateVariableNode(UEdGraph* EventGraph, FName VariableName) {
+	T* GetOwnerNode = NewObject<T>(EventGraph);
+	GetOwnerNode->VariableReference.SetSelfMember(VariableName);
+	GetOwnerNode->CreateNewGuid();
+	GetOwnerNode->PostPlacedNewNode();
+	GetOwnerNode->SetFlags(RF_Transactional);
+	GetOwnerNode->AllocateDefaultPins();
+	UEdGraphSchema_K2::SetNodeMetaData(GetOwnerNode, FNodeMetadata::DefaultGraphNode);
+	GetOwnerNode->SetEnabledState(ENodeEnabledState::Enabled);
+	EventGraph->AddNode(GetOwnerNode);
+	return GetOwnerNode;
+}
+
 
 static void CreateNodes() {
 	// FMessageDialog::Open(EAppMsgType::YesNo, FText::FromString("asdf"));
@@ -295,25 +342,42 @@ static void ParseFunctionDescription(const FString& FunctionDescription, TMap<FS
 	} while (ParamMatcher.FindNext());
 }
 
-static TArray<UProperty*> GetPropertiesFromClass(UClass* Class)
+static TArray<FProperty*> GetPropertiesFromStruct(UStruct* Struct)
 {
-	TArray<UProperty*> Properties;
+	TArray<FProperty*> Properties;
 
-	// Iterate through the class fields
-	for (TFieldIterator<UProperty> PropertyIt(Class, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt)
+	// Iterate through the class or struct fields
+	for (TFieldIterator<FProperty> PropertyIt(Struct, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt)
 	{
-		UProperty* Property = *PropertyIt;
-
-		// Check if the field is a property (variable)
-		if (Property->IsA(UProperty::StaticClass()))
-		{
-			Properties.Add(Property);
-		}
+		Properties.Add(*PropertyIt);
 	}
 
 	return Properties;
 }
 
+// GetCPPType alone drops container arguments, e.g. TArray<AActor*> comes back as TArray
+static FString GetFullCPPType(FProperty* Property)
+{
+	FString ExtendedTypeText;
+	FString TypeText = Property->GetCPPType(&ExtendedTypeText);
+	return TypeText + ExtendedTypeText;
+}
+
+// Interfaces count as members since Class->Interfaces only lists the ones declared on that class
+static bool DeclaresMembers(UClass* Class)
+{
+	return Class->Interfaces.Num() > 0 || TFieldIterator<UFunction>(Class, EFieldIteratorFlags::ExcludeSuper) || TFieldIterator<FProperty>(Class, EFieldIteratorFlags::ExcludeSuper);
+}
+
+// Classes without members of their own get no record, so link to the nearest ancestor that has one
+static UClass* GetExportedSuperClass(UClass* Class)
+{
+	UClass* SuperClass = Class->GetSuperClass();
+	while (SuperClass != nullptr && !DeclaresMembers(SuperClass))
+		SuperClass = SuperClass->GetSuperClass();
+	return SuperClass;
+}
+
 static FString GetStrippedClassName(UClass* Class)
 {
 	FString ClassName = Class->GetName();
@@ -345,7 +409,7 @@ struct FTypeInfo
 
 static TSharedPtr<FJsonObject> ParseCPPName(const FString& PropertyType)
 {
-	FRegexPattern TypePattern(TEXT("([A-Za-z_]+)\\s*(?:<([^<>]+)>\\s*)?(\\*?)"));
+	FRegexPattern TypePattern(TEXT("([A-Za-z_][A-Za-z0-9_]*)\\s*(?:<([^<>]+)>\\s*)?(\\*?)"));
 	FRegexMatcher TypeMatcher(TypePattern, PropertyType);
 
 	FString OuterType;
@@ -378,28 +442,325 @@ static TSharedPtr<FJsonObject> ParseCPPName(const FString& PropertyType)
 }
 
 
+static TAutoConsoleVariable<bool> CVarSplitMetadata(
+	TEXT("BPGen.SplitMetadata"),
+	false,
+	TEXT("Export signatures only to kismet.core.json and move tooltips and metadata to the kismet.meta.jsonl sidecar"));
+
+static FString SerializeCondensed(const TSharedRef<FJsonObject>& Object)
+{
+	FString OutputString;
+	TSharedRef< TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>> > Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutputString);
+	FJsonSerializer::Serialize(Object, Writer);
+	return OutputString;
+}
+
+static void SaveJsonToProjectFile(const TSharedRef<FJsonObject>& RootObject, const FString& FileName, bool bCondensed = false)
+{
+	FString OutputString;
+	if (bCondensed)
+	{
+		OutputString = SerializeCondensed(RootObject);
+	}
+	else
+	{
+		TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&OutputString);
+		FJsonSerializer::Serialize(RootObject, Writer);
+	}
+
+	FString Path = FPaths::Combine(FPaths::ProjectDir(), FileName);
+
+	// IFileHandle * pFile = FPlatformFileManager::Get().GetPlatformFile().OpenWrite( *Path );
+
+	FFileHelper::SaveStringToFile(OutputString, *Path);
+}
+
+// Groups records by package, e.g. "/Script/Engine" -> "Actor"
+static void AddToPackageObject(const TSharedRef<FJsonObject>& Packages, const FString& PathName, const TSharedRef<FJsonObject>& Object)
+{
+	TArray<FString> Substrings;
+	PathName.ParseIntoArray(Substrings, TEXT("."), true);
+	if (Substrings.Num() == 2)
+	{
+		if (Packages->HasField(Substrings[0]))
+		{
+			auto field = Packages->GetObjectField(Substrings[0]);
+			field->SetObjectField(Substrings[1], Object);
+		}
+		else
+		{
+			TSharedRef<FJsonObject> field = MakeShareable(new FJsonObject);
+			field->SetObjectField(Substrings[1], Object);
+			Packages->SetObjectField(Substrings[0], field);
+		}
+	}
+	else
+		Packages->SetObjectField(*PathName, Object);
+}
+
+// Path of the class, struct or enum a property refers to, looking through containers
+static FString GetPropertyTypePath(FProperty* Property)
+{
+	if (FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		Property = ArrayProperty->Inner;
+	else if (FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+		Property = SetProperty->ElementProp;
+	else if (FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+		Property = MapProperty->ValueProp;
+
+	if (Property == nullptr)
+		return FString();
+	if (FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		return StructProperty->Struct->GetPathName();
+	if (FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		return EnumProperty->GetEnum()->GetPathName();
+	if (FByteProperty* ByteProperty = CastField<FByteProperty>(Property))
+		return ByteProperty->Enum ? ByteProperty->Enum->GetPathName() : FString();
+	if (FClassProperty* ClassProperty = CastField<FClassProperty>(Property))
+		return ClassProperty->MetaClass->GetPathName();
+	if (FSoftClassProperty* SoftClassProperty = CastField<FSoftClassProperty>(Property))
+		return SoftClassProperty->MetaClass->GetPathName();
+	if (FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+		return ObjectProperty->PropertyClass->GetPathName();
+	if (FInterfaceProperty* InterfaceProperty = CastField<FInterfaceProperty>(Property))
+		return InterfaceProperty->InterfaceClass->GetPathName();
+	return FString();
+}
+
+struct FTypeIndexEntry
+{
+	FString Super;
+	TArray<int32> Inputs;
+	TArray<int32> Outputs;
+};
+
+// Keys use the full C++ type so FVector2D, int32 or TArray<AActor*> stay distinct from FVector, int or TArray<FName>
+static FString GetTypeIndexKey(const FString& FullType)
+{
+	return FullType.Replace(TEXT(" "), TEXT(""));
+}
+
+static FString GetClassCPPName(UClass* Class)
+{
+	return FString(Class->GetPrefixCPP()) + Class->GetName();
+}
+
+// Same spelling as GetCPPType of an object pointer, e.g. UTexture2D*
+static FString GetClassIndexKey(UClass* Class)
+{
+	return GetClassCPPName(Class) + TEXT("*");
+}
+
+// The class whose hierarchy a type follows: AActor for AActor*, TSubclassOf<AActor>, TSoftObjectPtr<AActor>,
+// TWeakObjectPtr<AActor> or TArray<AActor*>
+static UClass* GetPropertyHierarchyClass(FProperty* Property)
+{
+	if (FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		Property = ArrayProperty->Inner;
+	else if (FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+		Property = SetProperty->ElementProp;
+
+	if (FClassProperty* ClassProperty = CastField<FClassProperty>(Property))
+		return ClassProperty->MetaClass;
+	if (FSoftClassProperty* SoftClassProperty = CastField<FSoftClassProperty>(Property))
+		return SoftClassProperty->MetaClass;
+	if (FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+		return ObjectProperty->PropertyClass;
+	return nullptr;
+}
+
+// Swaps the class name inside a key as a whole word, e.g. TSubclassOf<ACharacter> -> TSubclassOf<APawn>
+static bool ReplaceClassInKey(const FString& Key, const FString& ClassName, const FString& NewClassName, FString& OutKey)
+{
+	auto IsNameChar = [](TCHAR Char) { return FChar::IsAlnum(Char) || Char == TEXT('_'); };
+	for (int32 Index = Key.Find(ClassName, ESearchCase::CaseSensitive); Index != INDEX_NONE; Index = Key.Find(ClassName, ESearchCase::CaseSensitive, ESearchDir::FromStart, Index + 1))
+	{
+		const int32 End = Index + ClassName.Len();
+		if ((Index > 0 && IsNameChar(Key[Index - 1])) || (End < Key.Len() && IsNameChar(Key[End])))
+			continue;
+		OutKey = Key.Left(Index) + NewClassName + Key.Mid(End);
+		return true;
+	}
+	return false;
+}
+
+static void AddFunctionId(TArray<int32>& FunctionIds, int32 FunctionId)
+{
+	// Ids are handed out in increasing order, so checking the tail keeps the list sorted and unique
+	if (!FunctionIds.Num() || FunctionIds.Last() != FunctionId)
+		FunctionIds.Add(FunctionId);
+}
+
+static void AddClassToTypeIndex(TMap<FString, FTypeIndexEntry>& TypeIndex, UClass* Class)
+{
+	if (UClass* SuperClass = Class->GetSuperClass())
+		TypeIndex.FindOrAdd(GetClassIndexKey(Class)).Super = GetClassIndexKey(SuperClass);
+}
+
+static void AddToTypeIndex(TMap<FString, FTypeIndexEntry>& TypeIndex, const FString& Key, FProperty* Param, int32 FunctionId, bool bIsInput)
+{
+	FTypeIndexEntry& Entry = TypeIndex.FindOrAdd(Key);
+	AddFunctionId(bIsInput ? Entry.Inputs : Entry.Outputs, FunctionId);
+
+	// Types wrapping a class (pointers, TSubclassOf, soft and weak pointers, arrays and sets of them) link to the
+	// same wrapper around the super class, so inputs are matched by walking up super; outputs are also listed under
+	// every base type they can stand in for. Plain UClass* has no class name in its key and is left alone.
+	UClass* HierarchyClass = GetPropertyHierarchyClass(Param);
+	if (HierarchyClass == nullptr)
+		return;
+
+	const FString ClassName = GetClassCPPName(HierarchyClass);
+	FString ClassKey = Key;
+	for (UClass* SuperClass = HierarchyClass->GetSuperClass(); SuperClass != nullptr; SuperClass = SuperClass->GetSuperClass())
+	{
+		FString SuperKey;
+		if (!ReplaceClassInKey(Key, ClassName, GetClassCPPName(SuperClass), SuperKey))
+			return;
+		TypeIndex.FindOrAdd(ClassKey).Super = SuperKey;
+		if (!bIsInput)
+			AddFunctionId(TypeIndex.FindOrAdd(SuperKey).Outputs, FunctionId);
+		ClassKey = SuperKey;
+	}
+}
+
+static TSharedRef<FJsonObject> ExportTypeIndex(TMap<FString, FTypeIndexEntry>& TypeIndex, const TArray< TSharedPtr<FJsonValue> >& FunctionPaths)
+{
+	TypeIndex.KeySort(TLess<FString>());
+
+	TSharedRef<FJsonObject> TypesObject = MakeShareable(new FJsonObject);
+	for (const auto& itr : TypeIndex)
+	{
+		TSharedRef<FJsonObject> TypeObject = MakeShareable(new FJsonObject);
+		if (!itr.Value.Super.IsEmpty())
+			TypeObject->SetStringField("super", itr.Value.Super);
+
+		TArray< TSharedPtr<FJsonValue> > Inputs;
+		for (int32 FunctionId : itr.Value.Inputs)
+			Inputs.Add(MakeShareable(new FJsonValueNumber(FunctionId)));
+		TypeObject->SetArrayField("inputs", Inputs);
+
+		TArray< TSharedPtr<FJsonValue> > Outputs;
+		for (int32 FunctionId : itr.Value.Outputs)
+			Outputs.Add(MakeShareable(new FJsonValueNumber(FunctionId)));
+		TypeObject->SetArrayField("outputs", Outputs);
+
+		TypesObject->SetObjectField(itr.Key, TypeObject);
+	}
+
+	TSharedRef<FJsonObject> IndexObject = MakeShareable(new FJsonObject);
+	IndexObject->SetArrayField("functions", FunctionPaths);
+	IndexObject->SetObjectField("types", TypesObject);
+	return IndexObject;
+}
+
+// GetPropertyTypePath follows a map's values; this covers its keys
+static FString GetPropertyKeyTypePath(FProperty* Property)
+{
+	FMapProperty* MapProperty = CastField<FMapProperty>(Property);
+	return MapProperty ? GetPropertyTypePath(MapProperty->KeyProp) : FString();
+}
+
+static TSharedRef<FJsonObject> ExportProperties(UStruct* Struct)
+{
+	TSharedRef<FJsonObject> PropertiesObject = MakeShareable(new FJsonObject);
+	for (FProperty* Property : GetPropertiesFromStruct(Struct))
+		PropertiesObject->SetStringField(Property->GetName(), GetFullCPPType(Property));
+	return PropertiesObject;
+}
+
+// Kept beside "properties" so that map stays name -> type string for existing consumers
+static void ExportPropertyTypePaths(UStruct* Struct, const TSharedRef<FJsonObject>& Object)
+{
+	TSharedRef<FJsonObject> TypePathsObject = MakeShareable(new FJsonObject);
+	TSharedRef<FJsonObject> KeyTypePathsObject = MakeShareable(new FJsonObject);
+	for (FProperty* Property : GetPropertiesFromStruct(Struct))
+	{
+		FString TypePath = GetPropertyTypePath(Property);
+		if (!TypePath.IsEmpty())
+			TypePathsObject->SetStringField(Property->GetName(), TypePath);
+		FString KeyTypePath = GetPropertyKeyTypePath(Property);
+		if (!KeyTypePath.IsEmpty())
+			KeyTypePathsObject->SetStringField(Property->GetName(), KeyTypePath);
+	}
+	if (TypePathsObject->Values.Num())
+		Object->SetObjectField("property_type_paths", TypePathsObject);
+	if (KeyTypePathsObject->Values.Num())
+		Object->SetObjectField("property_key_type_paths", KeyTypePathsObject);
+}
+
+static TSharedRef<FJsonObject> ExportEnum(UEnum* Enum)
+{
+	TSharedRef<FJsonObject> EnumObject = MakeShareable(new FJsonObject);
+	EnumObject->SetStringField("cppType", Enum->CppType);
+
+	TSharedRef<FJsonObject> ValuesObject = MakeShareable(new FJsonObject);
+	// Skip the generated _MAX entry
+	const int32 NumValues = Enum->ContainsExistingMax() ? Enum->NumEnums() - 1 : Enum->NumEnums();
+	for (int32 Index = 0; Index < NumValues; ++Index)
+		ValuesObject->SetNumberField(Enum->GetNameStringByIndex(Index), Enum->GetValueByIndex(Index));
+	EnumObject->SetObjectField("values", ValuesObject);
+
+	return EnumObject;
+}
+
+static TSharedRef<FJsonObject> ExportStruct(UScriptStruct* Struct)
+{
+	TSharedRef<FJsonObject> StructObject = MakeShareable(new FJsonObject);
+	StructObject->SetStringField("cppType", Struct->GetStructCPPName());
+	if (UStruct* SuperStruct = Struct->GetSuperStruct())
+		StructObject->SetStringField("super", SuperStruct->GetPathName());
+
+	StructObject->SetObjectField("properties", ExportProperties(Struct));
+	ExportPropertyTypePaths(Struct, StructObject);
+
+	return StructObject;
+}
+
 static void ExportFunctions() {
 	TSharedRef<FJsonObject> RootObject = MakeShareable(new FJsonObject);
 
 	TSharedRef<FJsonObject> Classes = MakeShareable(new FJsonObject);
+	TSharedRef<FJsonObject> Structs = MakeShareable(new FJsonObject);
+	TSharedRef<FJsonObject> Enums = MakeShareable(new FJsonObject);
+
+	// Cold text (tooltips, FMeta_*, PMeta_*) goes to one sidecar line per function id when split
+	const bool bSplitMetadata = CVarSplitMetadata.GetValueOnGameThread();
+	int32 NextFunctionId = 0;
+	FString MetadataLines;
+	int64 MetadataOffset = 0;
+	TArray< TSharedPtr<FJsonValue> > MetadataOffsets;
+
+	// Type -> function ids, so "what takes an AActor*" is a lookup instead of a scan over every pin
+	TMap<FString, FTypeIndexEntry> TypeIndex;
+	TArray< TSharedPtr<FJsonValue> > FunctionPaths;
+
+	// One pass over the object array picks up classes, structs and enums alike
+	for (TObjectIterator<UField> FieldIt; FieldIt; ++FieldIt) {
+		UField* const Field = (*FieldIt);
+
+		if (UEnum* const Enum = Cast<UEnum>(Field))
+		{
+			AddToPackageObject(Enums, Enum->GetPathName(), ExportEnum(Enum));
+			continue;
+		}
+		if (UScriptStruct* const Struct = Cast<UScriptStruct>(Field))
+		{
+			AddToPackageObject(Structs, Struct->GetPathName(), ExportStruct(Struct));
+			continue;
+		}
+
+		UClass* const Class = Cast<UClass>(Field);
+		if (Class == nullptr)
+			continue;
 
-	for (TObjectIterator<UClass> ClassIt; ClassIt; ++ClassIt) {
-		UClass* const Class = (*ClassIt);
+		// Every class gets its super link, so types that never appear on a pin can still be followed up to ones that do
+		AddClassToTypeIndex(TypeIndex, Class);
 		// UE_LOG(LogTemp, Display, TEXT("Found class %s"), *Class->GetPathName());
 
 		TSharedRef<FJsonObject> ClassObject = MakeShareable(new FJsonObject);
 
-		TSharedRef<FJsonObject> PropertiesObject = MakeShareable(new FJsonObject);
+		TSharedRef<FJsonObject> PropertiesObject = ExportProperties(Class);
 		TSharedRef<FJsonObject> FunctionsObject = MakeShareable(new FJsonObject);
-		TArray<UProperty*> properties = GetPropertiesFromClass(Class);
-		//Class->GetNativePropertyValues(tempPMap);
-		for (auto itr : properties)
-		{
-			FString PName = itr->GetName();
-			FString PType = itr->GetCPPType();
-			PropertiesObject->SetStringField(PName, PType);
-			//UE_LOG(LogBPGen, Log, TEXT("Name: %s, Type: %s"), *PName, *PType);
-		}
 
 		for (TFieldIterator<UFunction> FunctionIt(Class, EFieldIteratorFlags::ExcludeSuper); FunctionIt; ++FunctionIt) {
 			UFunction* Function = *FunctionIt;
@@ -407,7 +768,12 @@ static void ExportFunctions() {
 			TMap<FString, FString> tempMap;
 			ParseFunctionDescription(tooltip, tempMap);
 			TSharedRef<FJsonObject> FunctionObject = MakeShareable(new FJsonObject);
+			TSharedRef<FJsonObject> FunctionMetaObject = bSplitMetadata ? MakeShared<FJsonObject>() : FunctionObject;
+			TSharedRef<FJsonObject> PinsMetaObject = MakeShareable(new FJsonObject);
 
+			const int32 FunctionId = NextFunctionId++;
+			FunctionObject->SetNumberField("id", FunctionId);
+			FunctionPaths.Add(MakeShareable(new FJsonValueString(Function->GetPathName())));
 			FunctionObject->SetBoolField("pure", Function->HasAnyFunctionFlags(FUNC_BlueprintPure));
 
 			TArray< TSharedPtr<FJsonValue> > Pins;
@@ -419,6 +785,7 @@ static void ExportFunctions() {
 				FProperty* Param = *PropIt;
 
 				TSharedRef<FJsonObject> PinObject = MakeShareable(new FJsonObject);
+				TSharedRef<FJsonObject> PinMetaObject = bSplitMetadata ? MakeShared<FJsonObject>() : PinObject;
 				// UE_LOG(LogTemp, Display, TEXT("Found param %s"), *Param->GetName());
 
 				const bool bIsFunctionInput = !Param->HasAnyPropertyFlags(CPF_ReturnParm) && (!Param->HasAnyPropertyFlags(CPF_OutParm) || Param->HasAnyPropertyFlags(CPF_ReferenceParm));
@@ -427,21 +794,32 @@ static void ExportFunctions() {
 				const EEdGraphPinDirection Direction = bIsFunctionInput ? EGPD_Input : EGPD_Output;
 
 				PinObject->SetStringField("name", *Param->GetName().TrimStartAndEnd());
-				FString typeStr = *Param->GetCPPType().TrimStartAndEnd();
+				FString typeStr = GetFullCPPType(Param).TrimStartAndEnd();
 				PinObject->SetStringField("type", typeStr);
-				PinObject->SetObjectField("type_parsed", ParseCPPName(typeStr));
+				// Derivable from "type", so the split core leaves it out
+				if (!bSplitMetadata)
+					PinObject->SetObjectField("type_parsed", ParseCPPName(typeStr));
+				AddToTypeIndex(TypeIndex, GetTypeIndexKey(typeStr), Param, FunctionId, bIsFunctionInput);
+				FString typePath = GetPropertyTypePath(Param);
+				if (!typePath.IsEmpty())
+					PinObject->SetStringField("type_path", typePath);
+				FString keyTypePath = GetPropertyKeyTypePath(Param);
+				if (!keyTypePath.IsEmpty())
+					PinObject->SetStringField("key_type_path", keyTypePath);
 
 				
 				//PinObject->SetStringField("GetCPPTypeForwardDeclaration", *Param->GetMetaDataMap());
 				PinObject->SetStringField("direction", bIsFunctionInput ? "input" : "output");
 				PinObject->SetBoolField("isRef", bIsRefParam);
 				if (FString* tt = tempMap.Find(*Param->GetName()))
-					PinObject->SetStringField("tooltip", (*tt).TrimStartAndEnd());
+					PinMetaObject->SetStringField("tooltip", (*tt).TrimStartAndEnd());
 				const TMap<FName, FString>* metaData = Param->GetMetaDataMap();
 				if (metaData != nullptr)
 					for (auto itr : *metaData)
 						if (!itr.Value.IsEmpty())
-							PinObject->SetStringField(FString("PMeta_") + itr.Key.ToString(), itr.Value);
+							PinMetaObject->SetStringField(FString("PMeta_") + itr.Key.ToString(), itr.Value);
+				if (bSplitMetadata && PinMetaObject->Values.Num())
+					PinsMetaObject->SetObjectField(Param->GetName(), PinMetaObject);
 				
 				FString ToolTip = Param->GetMetaData("ToolTip");
 				FString DisplayName = Param->GetMetaData("DisplayName");
@@ -514,7 +892,7 @@ static void ExportFunctions() {
 				*/
 			}
 			
-			FunctionObject->SetStringField("tooltip", *tempMap.Find(L"MainDescription"));
+			FunctionMetaObject->SetStringField("tooltip", *tempMap.Find(L"MainDescription"));
 
 			static const FString validMData[] = {
 				L"CommutativeAssociativeBinaryOperator",
@@ -529,18 +907,28 @@ static void ExportFunctions() {
 			{
 				FString val = Function->GetMetaData(*itr);
 				if (!val.IsEmpty())
-					FunctionObject->SetStringField(FString(L"FMeta_") + itr, *val);
+					FunctionMetaObject->SetStringField(FString(L"FMeta_") + itr, *val);
 			}
 			// Only if there was something to parse
 			FString val = Function->GetMetaData("ToolTip");
 			if (!val.IsEmpty() && val.Len() > tempMap.Find(L"MainDescription")->Len())
-				FunctionObject->SetStringField(FString(L"FMeta_Tooltip"), *val);
+				FunctionMetaObject->SetStringField(FString(L"FMeta_Tooltip"), *val);
 
 			FunctionObject->SetArrayField("pins", Pins);
 			FunctionsObject->SetObjectField(Function->GetName(), FunctionObject);
+
+			if (bSplitMetadata)
+			{
+				// Byte offsets let readers seek straight to one record without parsing the rest
+				FunctionMetaObject->SetObjectField("pins", PinsMetaObject);
+				const FString Line = SerializeCondensed(FunctionMetaObject) + TEXT("\n");
+				MetadataOffsets.Add(MakeShareable(new FJsonValueNumber(MetadataOffset)));
+				MetadataOffset += FTCHARToUTF8(*Line).Length();
+				MetadataLines += Line;
+			}
 		}
 
-		if (FunctionsObject->Values.Num())
+		if (FunctionsObject->Values.Num() || PropertiesObject->Values.Num() || Class->Interfaces.Num())
 		{
 			
 			//ClassObject->SetStringField("GetAuthoredName", Class->GetAuthoredName());
@@ -548,58 +936,525 @@ static void ExportFunctions() {
 			//ClassObject->SetStringField("GetFName", Class->GetFName().ToString());
 			ClassObject->SetStringField("GetDisplayNameText", Class->GetDisplayNameText().ToString());
 			//ClassObject->SetStringField("GetFullGroupName", Class->GetFullGroupName(true));
-			ClassObject->SetStringField("GetDefaultObjectName", Class->GetDefaultObjectName().ToString());
+			if (!bSplitMetadata)
+				ClassObject->SetStringField("GetDefaultObjectName", Class->GetDefaultObjectName().ToString());
 			//ClassObject->SetStringField("GetFullName", Class->GetFullName());
+			if (UClass* SuperClass = GetExportedSuperClass(Class))
+				ClassObject->SetStringField("super", SuperClass->GetPathName());
+			TArray< TSharedPtr<FJsonValue> > Interfaces;
+			for (const FImplementedInterface& Interface : Class->Interfaces)
+				if (Interface.Class != nullptr)
+					Interfaces.Add(MakeShareable(new FJsonValueString(Interface.Class->GetPathName())));
+			if (Interfaces.Num())
+				ClassObject->SetArrayField("interfaces", Interfaces);
 			ClassObject->SetObjectField("properties", PropertiesObject);
+			ExportPropertyTypePaths(Class, ClassObject);
 			ClassObject->SetObjectField("functions", FunctionsObject);
 			/*Classes->GetObjectField*/
 
-			TArray<FString> Substrings;
-			Class->GetPathName().ParseIntoArray(Substrings, TEXT("."), true);
-			if (Substrings.Num() == 2)
-			{
-				
-				//if (field.IsValid())
-				if (Classes->HasField(Substrings[0]))
-				{
-					auto field = Classes->GetObjectField(Substrings[0]);
-					field->SetObjectField(Substrings[1], ClassObject);
-				}
-				else
-				{
-					TSharedRef<FJsonObject> field = MakeShareable(new FJsonObject);
-					field->SetObjectField(Substrings[1], ClassObject);
-					Classes->SetObjectField(Substrings[0], field);
-				}
-				/*if (field.IsValid() && field->Values.Num())
-					field->SetObjectField(Substrings[1], ClassObject);
-				else
-				{
-					field = MakeShareable(new FJsonObject);
-					field->SetObjectField(Substrings[1], ClassObject);
-					Classes->SetObjectField(Substrings[0], field);
-				}*/
-			}
-				//Classes->SetObjectField(*Class->GetPathName(), ClassObject);
-			else
-				Classes->SetObjectField(*Class->GetPathName(), ClassObject);
+			AddToPackageObject(Classes, Class->GetPathName(), ClassObject);
 		}
 		//Classes.Add(MakeShareable(new FJsonValueObject(ClassObject)));
 	}
 
 	RootObject->SetObjectField("classes", Classes);
+	RootObject->SetObjectField("structs", Structs);
+	RootObject->SetObjectField("enums", Enums);
 
-	FString OutputString;
-	TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&OutputString);
-	FJsonSerializer::Serialize(RootObject, Writer);
+	SaveJsonToProjectFile(ExportTypeIndex(TypeIndex, FunctionPaths), "kismet.index.json", true);
 
-	FString Path = FPaths::Combine(FPaths::ProjectDir(), FString("kismet.json"));
+	if (bSplitMetadata)
+	{
+		TSharedRef<FJsonObject> MetadataObject = MakeShareable(new FJsonObject);
+		MetadataObject->SetStringField("file", "kismet.meta.jsonl");
+		MetadataObject->SetArrayField("offsets", MetadataOffsets);
+		RootObject->SetObjectField("metadata", MetadataObject);
+
+		FString MetadataPath = FPaths::Combine(FPaths::ProjectDir(), FString("kismet.meta.jsonl"));
+		FFileHelper::SaveStringToFile(MetadataLines, *MetadataPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+		SaveJsonToProjectFile(RootObject, "kismet.core.json", true);
+	}
+	else
+	{
+		SaveJsonToProjectFile(RootObject, "kismet.json");
+	}
+}
 
-	// IFileHandle * pFile = FPlatformFileManager::Get().GetPlatformFile().OpenWrite( *Path );
+struct FGraphCostStats
+{
+	FString BlueprintPath;
+	FString GraphName;
+	int32 NodeCount = 0;
+	int32 ImpureCallCount = 0;
+	int32 LoopCount = 0;
+	int32 LatentCount = 0;
+	int32 CastCount = 0;
+	int32 BytecodeSize = 0;
+	TArray<FString> HeavyCalls;
+	float Score = 0.f;
+};
 
-	FFileHelper::SaveStringToFile(OutputString, *Path);
+// Functions whose cost scales with the world rather than with their inputs
+static const FString HeavyFunctionPrefixes[] = {
+	L"GetAllActors",
+	L"GetAllWidgetsOf"
+};
+
+static bool IsHeavyFunction(const UFunction* Function)
+{
+	const FString FunctionName = Function->GetName();
+	for (const FString& Prefix : HeavyFunctionPrefixes)
+		if (FunctionName.StartsWith(Prefix))
+			return true;
+	return false;
+}
+
+static bool IsLoopMacro(const UK2Node_MacroInstance* MacroNode)
+{
+	// ForLoop, ForEachLoop, WhileLoop and their WithBreak/Reverse variants from StandardMacros
+	const UEdGraph* MacroGraph = MacroNode->GetMacroGraph();
+	return MacroGraph != nullptr && MacroGraph->GetName().Contains(TEXT("Loop"));
+}
+
+static FGraphCostStats ProfileGraph(UBlueprint* Blueprint, UEdGraph* Graph)
+{
+	FGraphCostStats Stats;
+	Stats.BlueprintPath = Blueprint->GetPathName();
+	Stats.GraphName = Graph->GetName();
+
+	for (UEdGraphNode* Node : Graph->Nodes)
+	{
+		if (Node == nullptr)
+			continue;
+		Stats.NodeCount++;
+
+		if (UK2Node_CallFunction* CallNode = Cast<UK2Node_CallFunction>(Node))
+		{
+			if (!CallNode->IsNodePure())
+				Stats.ImpureCallCount++;
+			if (CallNode->IsLatentFunction())
+				Stats.LatentCount++;
+			UFunction* Target = CallNode->GetTargetFunction();
+			if (Target != nullptr && IsHeavyFunction(Target))
+				Stats.HeavyCalls.Add(Target->GetName());
+		}
+		else if (UK2Node_MacroInstance* MacroNode = Cast<UK2Node_MacroInstance>(Node))
+		{
+			if (IsLoopMacro(MacroNode))
+				Stats.LoopCount++;
+		}
+		else if (Node->IsA<UK2Node_DynamicCast>())
+		{
+			Stats.CastCount++;
+		}
+		else if (Node->IsA<UK2Node_BaseAsyncTask>())
+		{
+			Stats.LatentCount++;
+		}
+	}
+
+	// Event graph pages share one ubergraph function, whose bytecode is reported per Blueprint instead
+	UBlueprintGeneratedClass* GeneratedClass = Cast<UBlueprintGeneratedClass>(Blueprint->GeneratedClass);
+	if (GeneratedClass != nullptr && !Blueprint->UbergraphPages.Contains(Graph))
+		if (UFunction* CompiledFunction = GeneratedClass->FindFunctionByName(Graph->GetFName(), EIncludeSuperFlag::ExcludeSuper))
+			Stats.BytecodeSize = CompiledFunction->Script.Num();
+
+	// Rough runtime weight: loops and world-wide queries dominate, bytecode size breaks ties
+	Stats.Score = Stats.ImpureCallCount
+		+ 2.f * (Stats.LatentCount + Stats.CastCount)
+		+ 10.f * Stats.LoopCount
+		+ 50.f * Stats.HeavyCalls.Num()
+		+ Stats.BytecodeSize / 100.f;
+
+	return Stats;
+}
+
+static TArray<FSoftObjectPath> GetBlueprintsToProfile(const TArray<FString>& Args)
+{
+	TArray<FSoftObjectPath> AssetPaths;
+	for (const FString& Arg : Args)
+	{
+		// Package paths like /Game/BP/BP_Enemy name the package, not the Blueprint inside it
+		if (!Arg.Contains(TEXT(".")) && FPackageName::IsValidLongPackageName(Arg))
+			AssetPaths.Add(FSoftObjectPath(Arg + TEXT(".") + FPackageName::GetLongPackageAssetName(Arg)));
+		else
+			AssetPaths.Add(FSoftObjectPath(Arg));
+	}
+
+	if (!AssetPaths.Num())
+	{
+		TArray<FAssetData> SelectedAssets;
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+		ContentBrowserModule.Get().GetSelectedAssets(SelectedAssets);
+		for (const FAssetData& AssetData : SelectedAssets)
+			AssetPaths.Add(AssetData.ToSoftObjectPath());
+	}
+
+	return AssetPaths;
+}
+
+static void ProfileBlueprints(const TArray<FString>& Args)
+{
+	TArray<FSoftObjectPath> AssetPaths = GetBlueprintsToProfile(Args);
+	if (!AssetPaths.Num())
+	{
+		UE_LOG(LogBPGen, Warning, TEXT("ProfileBlueprints: No Blueprints selected"));
+		return;
+	}
+
+	// Issue every load at once so the async loader can stream packages in parallel; graph walking stays on the game thread
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> LoadHandle = StreamableManager.RequestSyncLoad(AssetPaths);
+
+	TArray<FGraphCostStats> GraphStats;
+	TSharedRef<FJsonObject> BlueprintsObject = MakeShareable(new FJsonObject);
+	for (const FSoftObjectPath& AssetPath : AssetPaths)
+	{
+		UBlueprint* Blueprint = Cast<UBlueprint>(AssetPath.ResolveObject());
+		if (Blueprint == nullptr)
+		{
+			UE_LOG(LogBPGen, Warning, TEXT("ProfileBlueprints: %s is not a Blueprint"), *AssetPath.ToString());
+			continue;
+		}
+
+		TArray<UEdGraph*> Graphs;
+		Blueprint->GetAllGraphs(Graphs);
+		for (UEdGraph* Graph : Graphs)
+			GraphStats.Add(ProfileGraph(Blueprint, Graph));
+
+		UBlueprintGeneratedClass* GeneratedClass = Cast<UBlueprintGeneratedClass>(Blueprint->GeneratedClass);
+		TSharedRef<FJsonObject> BlueprintObject = MakeShareable(new FJsonObject);
+		BlueprintObject->SetNumberField("ubergraphBytecodeSize", GeneratedClass && GeneratedClass->UberGraphFunction ? GeneratedClass->UberGraphFunction->Script.Num() : 0);
+		BlueprintsObject->SetObjectField(Blueprint->GetPathName(), BlueprintObject);
+	}
+
+	GraphStats.Sort([](const FGraphCostStats& A, const FGraphCostStats& B) { return A.Score > B.Score; });
+
+	TArray< TSharedPtr<FJsonValue> > Graphs;
+	for (const FGraphCostStats& Stats : GraphStats)
+	{
+		TSharedRef<FJsonObject> GraphObject = MakeShareable(new FJsonObject);
+		GraphObject->SetStringField("blueprint", Stats.BlueprintPath);
+		GraphObject->SetStringField("graph", Stats.GraphName);
+		GraphObject->SetNumberField("score", Stats.Score);
+		GraphObject->SetNumberField("nodes", Stats.NodeCount);
+		GraphObject->SetNumberField("impureCalls", Stats.ImpureCallCount);
+		GraphObject->SetNumberField("loops", Stats.LoopCount);
+		GraphObject->SetNumberField("latent", Stats.LatentCount);
+		GraphObject->SetNumberField("casts", Stats.CastCount);
+		GraphObject->SetNumberField("bytecodeSize", Stats.BytecodeSize);
+
+		TArray< TSharedPtr<FJsonValue> > HeavyCalls;
+		for (const FString& HeavyCall : Stats.HeavyCalls)
+			HeavyCalls.Add(MakeShareable(new FJsonValueString(HeavyCall)));
+		GraphObject->SetArrayField("heavyCalls", HeavyCalls);
+
+		Graphs.Add(MakeShareable(new FJsonValueObject(GraphObject)));
+	}
+
+	TSharedRef<FJsonObject> RootObject = MakeShareable(new FJsonObject);
+	RootObject->SetObjectField("blueprints", BlueprintsObject);
+	RootObject->SetArrayField("graphs", Graphs);
+
+	SaveJsonToProjectFile(RootObject, "bpprofile.json");
+	UE_LOG(LogBPGen, Display, TEXT("ProfileBlueprints: Wrote %d graphs"), GraphStats.Num());
+}
+
+static FAutoConsoleCommand ProfileBlueprintsCommand(
+	TEXT("BPGen.ProfileBlueprints"),
+	TEXT("Writes a ranked per-graph cost report to bpprofile.json for the given Blueprint paths, or the Content Browser selection"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ProfileBlueprints));
+
+struct FStressPhase
+{
+	double Seconds = 0.0;
+	int64 MemoryBytes = 0;
+};
+
+struct FStressPhaseScope
+{
+	FStressPhase& Phase;
+	double StartSeconds;
+	uint64 StartMemory;
+
+	FStressPhaseScope(FStressPhase& InPhase)
+		: Phase(InPhase), StartSeconds(FPlatformTime::Seconds()), StartMemory(FPlatformMemory::GetStats().UsedPhysical) {}
+
+	~FStressPhaseScope()
+	{
+		Phase.Seconds += FPlatformTime::Seconds() - StartSeconds;
+		Phase.MemoryBytes += static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(StartMemory);
+	}
+};
+
+static void AddStressFailure(TArray< TSharedPtr<FJsonValue> >& Failures, const FString& FunctionPath, const FString& Phase, const FString& Message)
+{
+	TSharedRef<FJsonObject> FailureObject = MakeShareable(new FJsonObject);
+	FailureObject->SetStringField("function", FunctionPath);
+	FailureObject->SetStringField("phase", Phase);
+	FailureObject->SetStringField("message", Message);
+	Failures.Add(MakeShareable(new FJsonValueObject(FailureObject)));
 }
 
+static TSharedRef<FJsonObject> ExportStressPhase(const FStressPhase& Phase)
+{
+	TSharedRef<FJsonObject> PhaseObject = MakeShareable(new FJsonObject);
+	PhaseObject->SetNumberField("seconds", Phase.Seconds);
+	PhaseObject->SetNumberField("memoryBytes", Phase.MemoryBytes);
+	return PhaseObject;
+}
+
+struct FStressVariable
+{
+	UK2Node_CallFunction* Node;
+	FName PinName;
+	FName VariableName;
+	bool bIsInput;
+};
+
+// The compiler prunes nodes that no event reaches before validating them, so every call node is wired up:
+// impure calls are chained from a custom event, pure outputs feed variable sets on the same chain,
+// and target or by-ref inputs that must be connected are fed from variable gets
+// Pure nodes without a visible, typed output have nothing to sink and are returned in OutUnwired
+static void WireStressBlueprint(UBlueprint* Blueprint, const TArray<UK2Node_CallFunction*>& CallNodes, TArray<UK2Node_CallFunction*>& OutUnwired)
+{
+	UEdGraph* EventGraph = Blueprint->UbergraphPages[0];
+	const UEdGraphSchema_K2* K2Schema = GetDefault<UEdGraphSchema_K2>();
+
+	TArray<FStressVariable> Variables;
+	for (UK2Node_CallFunction* Node : CallNodes)
+	{
+		const bool bIsPure = Node->IsNodePure();
+		bool bHasSink = false;
+		for (UEdGraphPin* Pin : Node->Pins)
+		{
+			if (Pin->bHidden || Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec || Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Wildcard)
+				continue;
+
+			const bool bIsTarget = Pin->PinName == UEdGraphSchema_K2::PN_Self && Pin->PinType.PinSubCategory != UEdGraphSchema_K2::PSC_Self;
+			const bool bNeedsSource = Pin->Direction == EGPD_Input && (bIsTarget || Pin->PinType.bIsReference);
+			const bool bNeedsSink = Pin->Direction == EGPD_Output && bIsPure && !bHasSink;
+			if (!bNeedsSource && !bNeedsSink)
+				continue;
+			bHasSink |= bNeedsSink;
+
+			FBPVariableDescription Variable;
+			Variable.VarName = FName(*FString::Printf(TEXT("Stress%d"), Blueprint->NewVariables.Num()));
+			Variable.VarGuid = FGuid::NewGuid();
+			Variable.VarType = Pin->PinType;
+			Variable.VarType.bIsReference = false;
+			Variable.VarType.bIsConst = false;
+			Variable.FriendlyName = Variable.VarName.ToString();
+			Variable.PropertyFlags = CPF_Edit | CPF_BlueprintVisible | CPF_DisableEditOnInstance;
+			Blueprint->NewVariables.Add(Variable);
+
+			Variables.Add({ Node, Pin->PinName, Variable.VarName, bNeedsSource });
+		}
+
+		if (bIsPure && !bHasSink)
+			OutUnwired.Add(Node);
+	}
+
+	// Adding the descriptions directly and regenerating the skeleton once avoids a rebuild per variable
+	FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
+
+	UK2Node_CustomEvent* EntryNode = CreateCustomEventNode(EventGraph, FName("BPGenStressEntry"));
+	EntryNode->NodePosX = -400;
+	UEdGraphPin* LastExecPin = K2Schema->FindExecutionPin(*EntryNode, EGPD_Output);
+	auto ChainExec = [&](UEdGraphNode* Node)
+	{
+		UEdGraphPin* ExecPin = K2Schema->FindExecutionPin(*Node, EGPD_Input);
+		if (LastExecPin == nullptr || ExecPin == nullptr)
+			return;
+		LastExecPin->MakeLinkTo(ExecPin);
+		LastExecPin = K2Schema->FindExecutionPin(*Node, EGPD_Output);
+	};
+
+	for (UK2Node_CallFunction* Node : CallNodes)
+		if (!Node->IsNodePure())
+			ChainExec(Node);
+
+	for (const FStressVariable& Variable : Variables)
+	{
+		// Pins are looked up again because regenerating the skeleton may have rebuilt them
+		UEdGraphPin* Pin = Variable.Node->FindPin(Variable.PinName);
+		if (Pin == nullptr)
+			continue;
+
+		if (Variable.bIsInput)
+		{
+			UK2Node_VariableGet* GetNode = CreateVariableNode<UK2Node_VariableGet>(EventGraph, Variable.VariableName);
+			GetNode->NodePosX = Variable.Node->NodePosX - 250;
+			GetNode->NodePosY = Variable.Node->NodePosY;
+			if (UEdGraphPin* ValuePin = GetNode->FindPin(Variable.VariableName))
+				ValuePin->MakeLinkTo(Pin);
+		}
+		else
+		{
+			UK2Node_VariableSet* SetNode = CreateVariableNode<UK2Node_VariableSet>(EventGraph, Variable.VariableName);
+			SetNode->NodePosX = Variable.Node->NodePosX + 250;
+			SetNode->NodePosY = Variable.Node->NodePosY;
+			if (UEdGraphPin* ValuePin = SetNode->FindPin(Variable.VariableName))
+				Pin->MakeLinkTo(ValuePin);
+			ChainExec(SetNode);
+		}
+	}
+}
+
+// CreateBlueprint marks Blueprints standalone, so they would otherwise survive into the next run
+static void ReleaseStressBlueprints(const TArray<UBlueprint*>& Blueprints)
+{
+	for (UBlueprint* Blueprint : Blueprints)
+	{
+		Blueprint->ClearFlags(RF_Standalone | RF_Public);
+		Blueprint->MarkPendingKill();
+	}
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+static void StressGraphs(const TArray<FString>& Args)
+{
+	const int32 NumBlueprints = Args.Num() ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1;
+
+	// The function list comes from the last export's index, ids in catalog order
+	FString IndexPath = FPaths::Combine(FPaths::ProjectDir(), FString("kismet.index.json"));
+	if (!FPaths::FileExists(IndexPath))
+		ExportFunctions();
+
+	FString IndexString;
+	TSharedPtr<FJsonObject> IndexObject;
+	if (!FFileHelper::LoadFileToString(IndexString, *IndexPath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(IndexString), IndexObject))
+	{
+		UE_LOG(LogBPGen, Error, TEXT("StressGraphs: Failed to read %s"), *IndexPath);
+		return;
+	}
+
+	TArray< TSharedPtr<FJsonValue> > Failures;
+	TArray<UFunction*> Functions;
+	TArray<FString> FunctionPaths;
+	int32 NumSkipped = 0;
+	for (const TSharedPtr<FJsonValue>& PathValue : IndexObject->GetArrayField("functions"))
+	{
+		const FString FunctionPath = PathValue->AsString();
+		FString ClassPath, FunctionName;
+		UClass* Class = FunctionPath.Split(TEXT(":"), &ClassPath, &FunctionName) ? FindObject<UClass>(nullptr, *ClassPath) : nullptr;
+		UFunction* Function = Class ? Class->FindFunctionByName(*FunctionName, EIncludeSuperFlag::ExcludeSuper) : nullptr;
+		if (Function == nullptr)
+			AddStressFailure(Failures, FunctionPath, "resolve", "Function no longer exists");
+		else if (!UEdGraphSchema_K2::CanUserKismetCallFunction(Function))
+			NumSkipped++;
+		else
+		{
+			Functions.Add(Function);
+			FunctionPaths.Add(FunctionPath);
+		}
+	}
+
+	// Progress and cancel polling happen outside the timed scopes, and only every few hundred nodes
+	static const int32 StressProgressInterval = 256;
+
+	FStressPhase CreatePhase, NodesPhase, WirePhase, CompilePhase;
+	FScopedSlowTask SlowTask(Functions.Num() + 3 * NumBlueprints, LOCTEXT("StressGraphs", "Generating stress Blueprints"));
+	SlowTask.MakeDialog(true);
+
+	TArray<UBlueprint*> Blueprints;
+	for (int32 Index = 0; Index < NumBlueprints; ++Index)
+	{
+		SlowTask.EnterProgressFrame();
+		FStressPhaseScope Scope(CreatePhase);
+		FName Name = MakeUniqueObjectName(GetTransientPackage(), UBlueprint::StaticClass(), FName("BPGenStress"));
+		Blueprints.Add(FKismetEditorUtilities::CreateBlueprint(AActor::StaticClass(), GetTransientPackage(), Name, BPTYPE_Normal, UBlueprint::StaticClass(), UBlueprintGeneratedClass::StaticClass()));
+	}
+
+	// Remembers which catalog entry each node came from so compiler errors can be attributed
+	TArray< TPair<UK2Node_CallFunction*, int32> > Nodes;
+	TArray< TArray<UK2Node_CallFunction*> > BlueprintNodes;
+	BlueprintNodes.SetNum(NumBlueprints);
+	bool bCancelled = false;
+	for (int32 Start = 0; Start < Functions.Num(); Start += StressProgressInterval)
+	{
+		if (SlowTask.ShouldCancel())
+		{
+			bCancelled = true;
+			break;
+		}
+		const int32 End = FMath::Min(Start + StressProgressInterval, Functions.Num());
+		SlowTask.EnterProgressFrame(End - Start);
+
+		FStressPhaseScope Scope(NodesPhase);
+		for (int32 Index = Start; Index < End; ++Index)
+		{
+			const int32 Slot = Index / NumBlueprints;
+			UEdGraph* EventGraph = Blueprints[Index % NumBlueprints]->UbergraphPages[0];
+			UK2Node_CallFunction* Node = CreateFunctionNode(EventGraph, Functions[Index]);
+			Node->NodePosX = (Slot % 50) * 400;
+			Node->NodePosY = (Slot / 50) * 300;
+			if (Node->GetTargetFunction() != Functions[Index] || !Node->Pins.Num())
+				AddStressFailure(Failures, FunctionPaths[Index], "create", "Node has no target function or pins");
+			else
+			{
+				Nodes.Add(TPair<UK2Node_CallFunction*, int32>(Node, Index));
+				BlueprintNodes[Index % NumBlueprints].Add(Node);
+			}
+		}
+	}
+
+	// A partial run would not be comparable with full ones, so nothing is reported
+	if (bCancelled)
+	{
+		UE_LOG(LogBPGen, Warning, TEXT("StressGraphs: Cancelled, no report written"));
+		ReleaseStressBlueprints(Blueprints);
+		return;
+	}
+
+	TArray<UK2Node_CallFunction*> Unwired;
+	for (int32 Index = 0; Index < NumBlueprints; ++Index)
+	{
+		SlowTask.EnterProgressFrame();
+		FStressPhaseScope Scope(WirePhase);
+		WireStressBlueprint(Blueprints[Index], BlueprintNodes[Index], Unwired);
+	}
+
+	for (UBlueprint* Blueprint : Blueprints)
+	{
+		SlowTask.EnterProgressFrame();
+		FStressPhaseScope Scope(CompilePhase);
+		FCompilerResultsLog Results;
+		FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection, &Results);
+	}
+
+	// Unwired nodes are pruned by the compiler, so they count as never validated rather than as successes
+	const TSet<UK2Node_CallFunction*> UnwiredSet(Unwired);
+	for (const TPair<UK2Node_CallFunction*, int32>& Node : Nodes)
+		if (UnwiredSet.Contains(Node.Key))
+			AddStressFailure(Failures, FunctionPaths[Node.Value], "wire", "Pure node has no output to connect");
+		else if (Node.Key->bHasCompilerMessage && Node.Key->ErrorType <= EMessageSeverity::Error)
+			AddStressFailure(Failures, FunctionPaths[Node.Value], "compile", Node.Key->ErrorMsg);
+
+	TSharedRef<FJsonObject> PhasesObject = MakeShareable(new FJsonObject);
+	PhasesObject->SetObjectField("create", ExportStressPhase(CreatePhase));
+	PhasesObject->SetObjectField("nodes", ExportStressPhase(NodesPhase));
+	PhasesObject->SetObjectField("wire", ExportStressPhase(WirePhase));
+	PhasesObject->SetObjectField("compile", ExportStressPhase(CompilePhase));
+
+	TSharedRef<FJsonObject> RootObject = MakeShareable(new FJsonObject);
+	RootObject->SetNumberField("blueprints", NumBlueprints);
+	RootObject->SetNumberField("functions", Functions.Num());
+	RootObject->SetNumberField("skipped", NumSkipped);
+	RootObject->SetObjectField("phases", PhasesObject);
+	RootObject->SetArrayField("failures", Failures);
+
+	SaveJsonToProjectFile(RootObject, "stress.json");
+	UE_LOG(LogBPGen, Display, TEXT("StressGraphs: %d functions in %d Blueprints, %d failures"), Functions.Num(), NumBlueprints, Failures.Num());
+
+	ReleaseStressBlueprints(Blueprints);
+}
+
+static FAutoConsoleCommand StressGraphsCommand(
+	TEXT("BPGen.StressGraphs"),
+	TEXT("Creates a call node for every callable exported function across [NumBlueprints] transient Blueprints, compiles them and writes timings and failures to stress.json"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&StressGraphs));
+
 static void Generate() {
 	ExportFunctions();
 }
@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BPGenClassResolver.h"
+
+FBPGenClassResolver::FBPGenClassResolver(const FJsonObject& CatalogObject)
+{
+	const TSharedPtr<FJsonObject>* Classes;
+	if (!CatalogObject.TryGetObjectField(TEXT("classes"), Classes))
+		return;
+
+	// Records are grouped by package, except for paths that didn't split into package and class
+	for (const auto& Package : (*Classes)->Values)
+	{
+		const TSharedPtr<FJsonObject>& PackageObject = Package.Value->AsObject();
+		if (PackageObject->HasField(TEXT("functions")))
+		{
+			ClassRecords.Add(Package.Key, PackageObject);
+			continue;
+		}
+		for (const auto& Class : PackageObject->Values)
+			ClassRecords.Add(Package.Key + TEXT(".") + Class.Key, Class.Value->AsObject());
+	}
+}
+
+const FBPGenFlattenedClass* FBPGenClassResolver::Resolve(const FString& ClassPath)
+{
+	if (const TSharedPtr<FBPGenFlattenedClass>* Cached = Flattened.Find(ClassPath))
+		return Cached->Get();
+
+	const TSharedPtr<FJsonObject>* Record = ClassRecords.Find(ClassPath);
+	if (Record == nullptr)
+		return nullptr;
+
+	TSharedPtr<FBPGenFlattenedClass> Result = MakeShared<FBPGenFlattenedClass>();
+
+	FString SuperPath;
+	if ((*Record)->TryGetStringField(TEXT("super"), SuperPath))
+		if (const FBPGenFlattenedClass* Super = Resolve(SuperPath))
+			*Result = *Super;
+
+	// Interface functions only fill gaps, the class chain's declarations win
+	const TArray< TSharedPtr<FJsonValue> >* Interfaces;
+	if ((*Record)->TryGetArrayField(TEXT("interfaces"), Interfaces))
+		for (const TSharedPtr<FJsonValue>& Interface : *Interfaces)
+			if (const FBPGenFlattenedClass* InterfaceClass = Resolve(Interface->AsString()))
+				for (const auto& Function : InterfaceClass->Functions)
+					if (!Result->Functions.Contains(Function.Key))
+						Result->Functions.Add(Function.Key, Function.Value);
+
+	AddOwnMembers(Result->Functions, **Record, TEXT("functions"), ClassPath);
+	AddOwnMembers(Result->Properties, **Record, TEXT("properties"), ClassPath);
+
+	Flattened.Add(ClassPath, Result);
+	return Result.Get();
+}
+
+void FBPGenClassResolver::AddOwnMembers(TMap<FString, FBPGenMember>& Members, const FJsonObject& Record, const FString& FieldName, const FString& ClassPath)
+{
+	const TSharedPtr<FJsonObject>* MembersObject;
+	if (!Record.TryGetObjectField(FieldName, MembersObject))
+		return;
+
+	for (const auto& Member : (*MembersObject)->Values)
+	{
+		FBPGenMember Own;
+		Own.OwnerPath = ClassPath;
+		if (const FBPGenMember* Inherited = Members.Find(Member.Key))
+			Own.OverriddenPath = Inherited->OwnerPath;
+		Own.Record = Member.Value;
+		Members.Add(Member.Key, Own);
+	}
+}
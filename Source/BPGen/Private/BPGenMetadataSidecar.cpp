@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BPGenMetadataSidecar.h"
+#include "BPGen.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+bool FBPGenMetadataSidecar::Open(const FString& CoreFilePath, const FJsonObject& CoreObject)
+{
+	const TSharedPtr<FJsonObject>* MetadataObject;
+	if (!CoreObject.TryGetObjectField(TEXT("metadata"), MetadataObject))
+	{
+		UE_LOG(LogBPGen, Warning, TEXT("MetadataSidecar: %s was not exported with split metadata"), *CoreFilePath);
+		return false;
+	}
+
+	SidecarPath = FPaths::Combine(FPaths::GetPath(CoreFilePath), (*MetadataObject)->GetStringField(TEXT("file")));
+
+	Offsets.Reset();
+	for (const TSharedPtr<FJsonValue>& Offset : (*MetadataObject)->GetArrayField(TEXT("offsets")))
+		Offsets.Add(static_cast<int64>(Offset->AsNumber()));
+
+	return true;
+}
+
+TSharedPtr<FJsonObject> FBPGenMetadataSidecar::LoadRecord(int32 FunctionId) const
+{
+	if (!Offsets.IsValidIndex(FunctionId))
+		return nullptr;
+
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*SidecarPath));
+	if (!File)
+	{
+		UE_LOG(LogBPGen, Warning, TEXT("MetadataSidecar: Failed to open %s"), *SidecarPath);
+		return nullptr;
+	}
+
+	// Records are newline terminated, so each one ends where the next begins
+	const int64 Start = Offsets[FunctionId];
+	const int64 End = Offsets.IsValidIndex(FunctionId + 1) ? Offsets[FunctionId + 1] : File->Size();
+
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized(End - Start);
+	if (!File->Seek(Start) || !File->Read(Bytes.GetData(), Bytes.Num()))
+		return nullptr;
+
+	FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+	FString Line(Converted.Length(), Converted.Get());
+
+	TSharedPtr<FJsonObject> Record;
+	TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(Line);
+	if (!FJsonSerializer::Deserialize(Reader, Record))
+		return nullptr;
+
+	return Record;
+}
@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+/** One member of a flattened class view */
+struct FBPGenMember
+{
+	/** Path of the class or interface whose declaration is in effect */
+	FString OwnerPath;
+
+	/** Path of the inherited declaration this one overrides, empty if it is not an override */
+	FString OverriddenPath;
+
+	/** The exported function or property record */
+	TSharedPtr<FJsonValue> Record;
+};
+
+struct FBPGenFlattenedClass
+{
+	TMap<FString, FBPGenMember> Functions;
+	TMap<FString, FBPGenMember> Properties;
+};
+
+/** Builds complete member lists from an export that only stores each class's own members */
+class BPGEN_API FBPGenClassResolver
+{
+public:
+
+	/** Indexes the classes section of a loaded kismet.json or kismet.core.json */
+	explicit FBPGenClassResolver(const FJsonObject& CatalogObject);
+
+	/** @return Own, inherited and interface members of a class, or nullptr if it isn't in the catalog. Computed once per class */
+	const FBPGenFlattenedClass* Resolve(const FString& ClassPath);
+
+private:
+
+	static void AddOwnMembers(TMap<FString, FBPGenMember>& Members, const FJsonObject& Record, const FString& FieldName, const FString& ClassPath);
+
+private:
+
+	TMap< FString, TSharedPtr<FJsonObject> > ClassRecords;
+
+	/** Shared pointers keep results stable while resolving a class adds its ancestors */
+	TMap< FString, TSharedPtr<FBPGenFlattenedClass> > Flattened;
+};
@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+/** Lazily reads single function metadata records from the sidecar written by a BPGen.SplitMetadata export */
+class BPGEN_API FBPGenMetadataSidecar
+{
+public:
+
+	/** Picks up the sidecar file name and record offsets from an already loaded kismet.core.json */
+	bool Open(const FString& CoreFilePath, const FJsonObject& CoreObject);
+
+	/** @return The tooltip and FMeta_/PMeta_ keys for one function id, or nullptr if it can't be read */
+	TSharedPtr<FJsonObject> LoadRecord(int32 FunctionId) const;
+
+	int32 Num() const { return Offsets.Num(); }
+
+private:
+
+	FString SidecarPath;
+
+	TArray<int64> Offsets;
+};